@@ -2418,6 +2418,20 @@ NTSTATUS WINAPI NtQueryInformationFile( HANDLE hFile, PIO_STATUS_BLOCK io,
             SERVER_END_REQ;
             if (!io->u.Status)
             {
+#ifdef __linux__
+                if (!server_get_unix_fd( hFile, FILE_READ_DATA, &fd, &needs_close, NULL, NULL ))
+                {
+                    int res;
+                    /* FIONREAD returns the size of the next pending datagram without
+                     * copying it out of the kernel, but cannot distinguish an empty
+                     * queue from a pending zero-size message, so peek in that case */
+                    if (ioctl( fd, FIONREAD, &res ) == -1 || !res)
+                        res = recv( fd, NULL, 0, MSG_PEEK | MSG_TRUNC );
+                    info->MessagesAvailable = (res > 0);
+                    info->NextMessageSize = (res >= 0) ? res : MAILSLOT_NO_MESSAGE;
+                    if (needs_close) close( fd );
+                }
+#else
                 char *tmpbuf;
                 ULONG size = info->MaximumMessageSize ? info->MaximumMessageSize : 0x10000;
                 if (size > 0x10000) size = 0x10000;
@@ -2432,6 +2446,7 @@ NTSTATUS WINAPI NtQueryInformationFile( HANDLE hFile, PIO_STATUS_BLOCK io,
                     }
                     RtlFreeHeap( GetProcessHeap(), 0, tmpbuf );
                 }
+#endif
             }
         }
         break;
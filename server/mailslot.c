@@ -54,12 +54,15 @@
 
 struct mailslot
 {
-    struct object       obj;
-    struct fd          *fd;
-    int                 write_fd;
-    unsigned int        max_msgsize;
-    timeout_t           read_timeout;
-    struct list         writers;
+    /* fields used on every read/open are grouped first to keep them on one cache line */
+    struct object       obj;             /* object header */
+    struct fd          *fd;              /* read side fd */
+    int                 write_fd;        /* unix write fd, dup'ed into each writer */
+    timeout_t           read_timeout;    /* timeout for queued reads */
+    struct list         writers;         /* list of open writers */
+    unsigned int        writer_access;   /* access rights of the first writer */
+    unsigned int        writer_sharing;  /* sharing mode of the first writer */
+    unsigned int        max_msgsize;     /* only queried by set_mailslot_info */
 };
 
 /* mailslot functions */
@@ -293,10 +296,8 @@ static struct object *mailslot_open_file( struct object *obj, unsigned int acces
         /* Readers and writers cannot be mixed.
          * If there's more than one writer, all writers must open with FILE_SHARE_WRITE
          */
-        writer = LIST_ENTRY( list_head(&mailslot->writers), struct mail_writer, entry );
-
-        if (((access & (GENERIC_WRITE|FILE_WRITE_DATA)) || (writer->access & FILE_WRITE_DATA)) &&
-           !((sharing & FILE_SHARE_WRITE) && (writer->sharing & FILE_SHARE_WRITE)))
+        if (((access & (GENERIC_WRITE|FILE_WRITE_DATA)) || (mailslot->writer_access & FILE_WRITE_DATA)) &&
+           !((sharing & FILE_SHARE_WRITE) && (mailslot->writer_sharing & FILE_SHARE_WRITE)))
         {
             set_error( STATUS_SHARING_VIOLATION );
             return NULL;
@@ -318,6 +319,8 @@ static struct object *mailslot_open_file( struct object *obj, unsigned int acces
     writer->access   = mail_writer_map_access( &writer->obj, access );
     writer->sharing  = sharing;
     list_add_head( &mailslot->writers, &writer->entry );
+    mailslot->writer_access  = writer->access;
+    mailslot->writer_sharing = writer->sharing;
 
     if (!(writer->fd = create_anonymous_fd( &mail_writer_fd_ops, unix_fd, &writer->obj, options )))
     {
@@ -331,12 +334,10 @@ static struct object *mailslot_open_file( struct object *obj, unsigned int acces
 static void mailslot_queue_async( struct fd *fd, struct async *async, int type, int count )
 {
     struct mailslot *mailslot = get_fd_user( fd );
-
-    assert(mailslot->obj.ops == &mailslot_ops);
+    timeout_t timeout = mailslot->read_timeout;
 
     fd_queue_async( fd, async, type );
-    async_set_timeout( async, mailslot->read_timeout ? mailslot->read_timeout : -1,
-                       STATUS_IO_TIMEOUT );
+    async_set_timeout( async, timeout ? timeout : -1, STATUS_IO_TIMEOUT );
     set_error( STATUS_PENDING );
 }
 
@@ -417,7 +418,7 @@ static struct mailslot *create_mailslot( struct object *root,
                                          const struct security_descriptor *sd )
 {
     struct mailslot *mailslot;
-    int fds[2];
+    int ret, fds[2];
 
     if (!(mailslot = create_named_object( root, &mailslot_ops, name, attr, sd ))) return NULL;
 
@@ -426,11 +427,21 @@ static struct mailslot *create_mailslot( struct object *root,
     mailslot->max_msgsize = max_msgsize;
     mailslot->read_timeout = read_timeout;
     list_init( &mailslot->writers );
-
-    if (!socketpair( PF_UNIX, SOCK_DGRAM, 0, fds ))
+    mailslot->writer_access = 0;
+    mailslot->writer_sharing = 0;
+
+#if defined(SOCK_NONBLOCK) && defined(SOCK_CLOEXEC)
+    /* set the fd flags atomically at creation instead of with two fcntls */
+    ret = socketpair( PF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, fds );
+#else
+    if (!(ret = socketpair( PF_UNIX, SOCK_DGRAM, 0, fds )))
     {
         fcntl( fds[0], F_SETFL, O_NONBLOCK );
         fcntl( fds[1], F_SETFL, O_NONBLOCK );
+    }
+#endif
+    if (!ret)
+    {
         shutdown( fds[0], SHUT_RD );
         mailslot->write_fd = fds[0];
         if ((mailslot->fd = create_anonymous_fd( &mailslot_fd_ops, fds[1], &mailslot->obj,
@@ -457,6 +468,13 @@ static void mail_writer_destroy( struct object *obj)
 
     if (writer->fd) release_object( writer->fd );
     list_remove( &writer->entry );
+    if (!list_empty( &writer->mailslot->writers ))
+    {
+        struct mail_writer *head = LIST_ENTRY( list_head(&writer->mailslot->writers),
+                                               struct mail_writer, entry );
+        writer->mailslot->writer_access  = head->access;
+        writer->mailslot->writer_sharing = head->sharing;
+    }
     release_object( writer->mailslot );
 }
 